@@ -6,13 +6,23 @@
  * Ctrl+C (SIGINT) 시그널을 처리하여 데이터 손실 없이 안전하게 종료하는 기능이 포함되어 있습니다.
  * ROOT TTree는 내부적으로 자동 저장(Auto-Save/Flush) 메커니즘을 가지고 있어,
  * 프로그램이 비정상 종료되어도 대부분의 데이터는 안전하게 보존됩니다.
+ *
+ * '-s' 옵션을 주면 읽은 hit 배치를 Unix-domain 소켓으로도 발행(HitPublisher)하여,
+ * 모니터링/온라인 분석 등 별도의 프로세스가 HitSubscriber로 실시간 데이터를 받을 수 있습니다.
+ *
+ * '-L' 옵션을 주면 물리 데이터의 TDC 코드 분포로 LUT를 주기적으로 재계산(LutDriftMonitor)하여,
+ * 적용 범위(TTree entry 번호)가 기록된 버전별 LUT 스냅샷을 저장합니다. (별도의 캘리브레이션 세션 없이 온도 드리프트 추적)
  */
 #include "TdcController.h"
+#include "HitPublisher.h"
+#include "HitStream.h"
+#include "TdcCalibration.h"
 #include "TFile.h"
 #include "TTree.h"
 #include <iostream>
 #include <string>
 #include <vector>
+#include <memory>
 #include <csignal>
 #include <unistd.h>
 #include <fstream>
@@ -26,21 +36,17 @@ struct TdcEvent {
     ULong64_t timestamp = 0;
 
     /**
-     * @brief 8바이트 버퍼를 파싱하여 멤버 변수를 채웁니다.
+     * @brief 8바이트 버퍼를 파싱하여 멤버 변수를 채웁니다. (디코딩은 lib의 TdcHit::parse와 공유)
      * @param buffer TDC raw 데이터 포인터 (8바이트)
      * @param global_event_id 전역 이벤트 카운터
      */
     void parse(const char* buffer, UInt_t& global_event_id) {
-        event_id = global_event_id;
-        // LSB first
-        tdc = (static_cast<uint8_t>(buffer[1]) << 8) | static_cast<uint8_t>(buffer[0]);
-        timestamp = 0;
-        for (int i = 0; i < 5; ++i) {
-            timestamp |= static_cast<ULong64_t>(static_cast<uint8_t>(buffer[i + 2])) << (i * 8);
-        }
-        // 하드웨어 timestamp 단위가 8ps이므로 TTree에는 ps 단위로 변환하여 저장
-        timestamp *= 8;
-        channel = static_cast<uint8_t>(buffer[7]);
+        TdcHit hit;
+        hit.parse(buffer, global_event_id);
+        event_id = hit.event_id;
+        channel = hit.channel;
+        tdc = hit.tdc;
+        timestamp = hit.timestamp; // ps 단위
     }
 };
 
@@ -49,12 +55,14 @@ volatile sig_atomic_t g_signal_status = 0;
 void signal_handler(int signal) { g_signal_status = signal; }
 
 void print_usage(const char* prog_name) {
-    std::cerr << "Usage: " << prog_name << " -o <outfile.root> -c <config.txt> [-t <sec>] [-ip <ip_override>]" << std::endl;
+    std::cerr << "Usage: " << prog_name << " -o <outfile.root> -c <config.txt> [-t <sec>] [-ip <ip_override>] [-s <stream.sock>]"
+              << " [-L <lut_prefix> [-W <window_sec=600>] [-N <windows_per_lut=6>]]" << std::endl;
 }
 
 int main(int argc, char *argv[]) {
-    std::string ip_addr, out_filename, config_filename;
+    std::string ip_addr, out_filename, config_filename, stream_path, lut_prefix;
     int acq_time = 0;
+    int lut_window_sec = 600, lut_windows = 6;
 
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -62,12 +70,20 @@ int main(int argc, char *argv[]) {
         else if (arg == "-c") config_filename = argv[++i];
         else if (arg == "-t") acq_time = std::stoi(argv[++i]);
         else if (arg == "-ip") ip_addr = argv[++i];
+        else if (arg == "-s") stream_path = argv[++i];
+        else if (arg == "-L") lut_prefix = argv[++i];
+        else if (arg == "-W") lut_window_sec = std::stoi(argv[++i]);
+        else if (arg == "-N") lut_windows = std::stoi(argv[++i]);
     }
 
     if (out_filename.empty() || config_filename.empty()) {
         print_usage(argv[0]);
         return 1;
     }
+    if (!lut_prefix.empty() && (lut_window_sec <= 0 || lut_windows <= 0)) {
+        std::cerr << "Error: -W (window seconds) and -N (windows per LUT) must be at least 1." << std::endl;
+        return 1;
+    }
 
     // --- 설정 파일 파싱 ---
     std::ifstream config_file(config_filename);
@@ -109,6 +125,23 @@ int main(int argc, char *argv[]) {
             tdc.setThreshold(ch, thresholds[ch-1]);
         }
 
+        // 설정 오류로 인한 예외가 ROOT 파일을 연 뒤에 발생하지 않도록 먼저 생성
+        // 구독자 전송은 별도 스레드에서 처리되므로 느린 구독자가 DAQ 루프를 멈추지 않음
+        std::unique_ptr<HitPublisher> publisher;
+        if (!stream_path.empty()) {
+            publisher = std::make_unique<HitPublisher>(stream_path);
+            std::cout << "Publishing hits on " << stream_path << std::endl;
+        }
+
+        // 창(window)이 닫힐 때만 LUT를 재계산하므로 hit당 비용은 히스토그램 누적 한 번.
+        // 스냅샷 기록 오류는 모니터 내부에서 처리되어 DAQ를 중단시키지 않음
+        std::unique_ptr<LutDriftMonitor> drift_monitor;
+        if (!lut_prefix.empty()) {
+            drift_monitor = std::make_unique<LutDriftMonitor>(lut_prefix, lut_window_sec, lut_windows);
+            std::cout << "LUT drift monitor: " << lut_window_sec << " s windows, LUT from last "
+                      << lut_windows << " windows -> " << lut_prefix << ".idx" << std::endl;
+        }
+
         TFile* outfile = TFile::Open(out_filename.c_str(), "RECREATE");
         TTree* tree = new TTree("tdc_tree", "TDC4CH Data");
         TdcEvent event;
@@ -130,22 +163,33 @@ int main(int argc, char *argv[]) {
             int data_size = tdc.getDataSize();
             if (data_size > 0) {
                 auto data_buffer = tdc.readData(data_size);
+                UInt_t first_event_id = event_counter;
                 for (int i = 0; i < data_size; ++i) {
                     // TTree::Fill()은 내부적으로 '바스켓(Basket)'이라는 메모리 버퍼에 데이터를 채웁니다.
                     // 이 바스켓이 가득 차면 ROOT가 자동으로 파일에 데이터를 쓰는 'Auto-Flush' 기능이 동작하므로,
                     // 프로그램이 비정상적으로 종료되어도 대부분의 데이터는 안전하게 보존됩니다.
                     event.parse(&data_buffer[i * 8], event_counter);
                     tree->Fill();
+                    if (drift_monitor) drift_monitor->add(event.channel, event.tdc);
                     event_counter++;
                 }
+                if (publisher) {
+                    // raw 버퍼를 그대로 넘겨 모든 구독자가 복사 없이 공유
+                    publisher->publish(std::make_shared<const std::vector<char>>(std::move(data_buffer)), first_event_id);
+                }
                 total_events_read += data_size;
                 std::cout << "Read " << total_events_read << " events...\r" << std::flush;
             }
+            if (drift_monitor) drift_monitor->update();
             usleep(10000); // 10ms 대기 (CPU 부하 감소)
         }
         
         // DAQ 루프가 모두 끝난 후, 메모리 버퍼에 남아있는 마지막 데이터를 모두 파일에 기록합니다.
         std::cout << "\nDAQ finished. Total events saved: " << total_events_read << std::endl;
+        if (drift_monitor) {
+            drift_monitor->finish();
+            std::cout << "LUT snapshots saved: " << drift_monitor->snapshotCount() << std::endl;
+        }
         outfile->Write();
         outfile->Close();
 
@@ -0,0 +1,75 @@
+/**
+ * @file tdc_apply_lut.cpp
+ * @brief frontend_tdc_mini의 원본 데이터에 LUT 드리프트 모니터('-L')가 기록한 버전별 LUT를 적용하는 프로그램.
+ *
+ * 입력 tdc_tree의 모든 브랜치를 그대로 복사하고, hit마다 해당 entry 번호에 맞는 LUT로 보정한
+ * 'tdc_cal' 브랜치를 추가하여 새로운 ROOT 파일로 저장합니다.
+ * 출력 파일은 같은 tdc_tree 이름을 가지므로 measure_lifetime, tdc_viewer 등의 입력으로 그대로 사용할 수 있습니다.
+ */
+#include "TdcCalibration.h"
+#include "TFile.h"
+#include "TTree.h"
+#include <iostream>
+#include <string>
+#include <cstdio>
+
+void apply_lut(const std::string& infile_name, const std::string& index_name, const std::string& outfile_name) {
+    LutTimeline luts;
+    luts.load(index_name);
+    std::cout << "Loaded " << luts.size() << " LUT snapshots from " << index_name << std::endl;
+
+    TFile* infile = TFile::Open(infile_name.c_str(), "READ");
+    if (!infile || infile->IsZombie()) {
+        std::cerr << "Error opening input file: " << infile_name << std::endl;
+        return;
+    }
+    TTree* intree = static_cast<TTree*>(infile->Get("tdc_tree"));
+    if (!intree) {
+        std::cerr << "Error: tdc_tree not found in " << infile_name << std::endl;
+        infile->Close();
+        return;
+    }
+
+    luts.checkEntries(static_cast<uint64_t>(intree->GetEntries()));
+
+    UInt_t channel = 0, tdc = 0;
+    intree->SetBranchAddress("channel", &channel);
+    intree->SetBranchAddress("tdc", &tdc);
+
+    TFile* outfile = new TFile(outfile_name.c_str(), "RECREATE");
+    TTree* outtree = intree->CloneTree(0);
+    Short_t tdc_cal = 0; // LUT 보정된 TDC 값 (LUT 파일과 같은 short)
+    outtree->Branch("tdc_cal", &tdc_cal);
+
+    // LUT 인덱스는 frontend TTree의 entry 번호로 기록되므로 entry 순서대로 보정
+    const Long64_t total_entries = intree->GetEntries();
+    for (Long64_t entry = 0; entry < total_entries; ++entry) {
+        intree->GetEntry(entry);
+        tdc_cal = luts.calibrate(channel, tdc, static_cast<uint64_t>(entry));
+        outtree->Fill();
+        if ((entry + 1) % 100000 == 0) {
+            printf("Processing... %lld / %lld\r", static_cast<long long>(entry + 1), static_cast<long long>(total_entries));
+            fflush(stdout);
+        }
+    }
+    std::cout << "\nCalibrated " << total_entries << " hits." << std::endl;
+
+    outfile->Write();
+    outfile->Close();
+    infile->Close();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <input.root> <lut_prefix.idx> <output.root>" << std::endl;
+        return 1;
+    }
+
+    try {
+        apply_lut(argv[1], argv[2], argv[3]);
+    } catch (const std::exception& e) {
+        std::cerr << "An error occurred: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
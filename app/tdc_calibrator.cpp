@@ -8,6 +8,8 @@
 #include <algorithm>
 #include <unistd.h>
 #include "TdcController.h"
+#include "TdcCalibration.h"
+#include "HitStream.h"
 
 bool calibrate_channel(TdcController& tdc, int channel, std::vector<short>& lut) {
     const int TOTAL_EVENTS = 100000;
@@ -22,7 +24,7 @@ bool calibrate_channel(TdcController& tdc, int channel, std::vector<short>& lut)
     tdc.setAcquisitionTime(0);
     tdc.start();
 
-    std::vector<int> hist(4096, 0);
+    std::vector<long> hist(TDC_CODES, 0);
     int events_taken = 0;
 
     std::cout << "Acquiring " << TOTAL_EVENTS << " events..." << std::endl;
@@ -31,10 +33,11 @@ bool calibrate_channel(TdcController& tdc, int channel, std::vector<short>& lut)
         if (data_size > 0) {
             int to_read = std::min(data_size, (TOTAL_EVENTS - events_taken));
             auto data_buffer = tdc.readData(to_read);
+            TdcHit hit;
             for (int i = 0; i < to_read; ++i) {
-                int tdc_val = (static_cast<uint8_t>(data_buffer[i*8+1]) << 8) | static_cast<uint8_t>(data_buffer[i*8]);
-                if (tdc_val >= 0 && tdc_val < 4096) {
-                    hist[tdc_val]++;
+                hit.parse(&data_buffer[i * 8], events_taken + i);
+                if (hit.tdc < TDC_CODES) {
+                    hist[hit.tdc]++;
                 }
             }
             events_taken += to_read;
@@ -48,19 +51,8 @@ bool calibrate_channel(TdcController& tdc, int channel, std::vector<short>& lut)
     tdc.setRawMode(false);
     std::cout << "\nData acquisition finished." << std::endl;
 
-    double cnt_all = events_taken;
-    double bin_begin = 0.0, bin_end = 0.0;
-    double cnt_begin = 0.0, cnt_end = 0.0;
-
-    for (int i = 0; i < 4096; ++i) {
-        cnt_end += hist[4095 - i];
-        bin_end += ((cnt_end - cnt_begin) / cnt_all * 1000.0);
-        lut[4095 - i] = static_cast<short>((bin_end + bin_begin) / 2.0 + 0.5);
-        cnt_begin = cnt_end;
-        bin_begin = bin_end;
-    }
-    lut[0] = 0;
-    for (int i = 1; i < 4096; ++i) lut[i] += 1;
+    // 누적합 LUT 계산 (LutDriftMonitor와 동일한 알고리즘)
+    computeLut(hist, lut);
     
     std::cout << "LUT for channel " << channel << " calculated." << std::endl;
     return true;
@@ -0,0 +1,55 @@
+/**
+ * @file tdc_stream_monitor.cpp
+ * @brief frontend_tdc_mini가 발행하는 hit 스트림에 접속하여 채널별 rate를 실시간으로 출력하는 모니터링 프로그램.
+ *
+ * DAQ와 별도의 프로세스로 실행되며, 언제든지 접속하거나 Ctrl+C로 종료할 수 있습니다.
+ * 기본 정책(Drop)에서는 모니터가 느려도 DAQ에 영향이 없으며, 버려진 배치 수를 함께 출력합니다.
+ */
+#include "HitSubscriber.h"
+#include "TdcController.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <array>
+#include <chrono>
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3 || (argc == 3 && std::string(argv[2]) != "-b")) {
+        std::cerr << "Usage: " << argv[0] << " <stream.sock> [-b (block policy: no dropped batches)]" << std::endl;
+        return 1;
+    }
+    const StreamPolicy policy = (argc == 3) ? StreamPolicy::Block : StreamPolicy::Drop;
+
+    try {
+        HitSubscriber subscriber;
+        subscriber.connect(argv[1], policy);
+        std::cout << "Connected to " << argv[1] << ". Press Ctrl+C to stop." << std::endl;
+
+        std::vector<TdcHit> hits;
+        std::array<long, 4> counts{};
+        auto t_last = std::chrono::steady_clock::now();
+
+        while (subscriber.receive(hits)) {
+            for (const auto& hit : hits) {
+                if (hit.channel >= 1 && hit.channel <= 4) counts[hit.channel - 1]++;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            double elapsed = std::chrono::duration<double>(now - t_last).count();
+            if (elapsed >= 1.0) {
+                printf("CH1 %8.1f Hz | CH2 %8.1f Hz | CH3 %8.1f Hz | CH4 %8.1f Hz | dropped batches %llu\r",
+                       counts[0] / elapsed, counts[1] / elapsed, counts[2] / elapsed, counts[3] / elapsed,
+                       static_cast<unsigned long long>(subscriber.droppedBatches()));
+                fflush(stdout);
+                counts.fill(0);
+                t_last = now;
+            }
+        }
+        std::cout << (subscriber.streamEnded() ? "\nStream ended." : "\nDisconnected by publisher.")
+                  << " Dropped batches: " << subscriber.droppedBatches() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "An error occurred: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,408 @@
+/**
+ * @file tdc_threshold_scan.cpp
+ * @brief 4개 채널의 임계값(Threshold)을 자동으로 스캔하여 singles/coincidence rate 곡선을 측정하는 프로그램.
+ *
+ * 각 스캔 지점에서 4개 채널의 임계값을 동일한 값으로 설정하고 DAQ를 짧게 실행하여,
+ * 채널별 singles rate, 다른 채널과 동시 발생한(coincident) hit의 rate, 그리고 2채널 이상 coincidence 이벤트 rate를 측정합니다.
+ *
+ * --- 측정 방식 ---
+ * 1. Dwell time 적응: 모든 채널의 hit 수가 목표 상대 정밀도(1/sqrt(N))에 도달하거나 최대 dwell time에 도달하면 다음 지점으로 이동합니다.
+ * 2. 레지스터 파이프라이닝: 임계값 설정(setThresholds)과 데이터 크기 조회(getDataSize)는 한 번의 왕복으로 처리됩니다.
+ * 3. 임계값 추천: 채널별 우연(accidental) coincidence를 뺀 coincidence 비율((coincident - accidental) / singles)이
+ *    최대값의 일정 비율 이상이 되는 가장 낮은 임계값을 추천합니다.
+ *    (노이즈 벽 안에서는 거의 모든 hit이 우연히 coincidence가 되므로 이 비율이 0에 가깝고, 노이즈 벽을 넘어서면 plateau에 도달합니다.)
+ *    초과분이 포아송 오차의 k배(기본 5 sigma)를 넘는 지점만 사용하므로, 신호가 없는 채널은 추천하지 않고 기존 값을 유지합니다.
+ *
+ * 결과는 텍스트 파일로 저장되며, '-u' 옵션을 주면 추천 임계값을 설정 파일에 다시 기록합니다.
+ */
+#include "TdcController.h"
+#include "HitStream.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <algorithm>
+#include <unistd.h>
+
+/// @brief 하나의 스캔 지점(임계값)에서 측정된 결과
+struct ScanPoint {
+    int threshold = 0;
+    double dwell_sec = 0.0;
+    std::array<long, 4> singles{};      // 채널별 전체 hit 수
+    std::array<long, 4> coincident{};   // 다른 채널과 coincidence window 안에서 함께 발생한 hit 수
+    long coincidence_events = 0;        // 2개 이상의 채널이 포함된 이벤트 수
+    bool saturated = false;             // 데이터 크기 레지스터가 최대값에 도달 (읽기가 밀려 rate를 신뢰할 수 없음)
+};
+
+/// @brief getDataSize()가 반환할 수 있는 최대값 (16비트 레지스터). 이 값이면 버퍼에 더 많은 데이터가 남아 있을 수 있습니다.
+constexpr int DATA_SIZE_MAX = 0xFFFF;
+
+/**
+ * @brief 시간순 hit을 coincidence window 단위로 묶어 집계하는 구조체.
+ * 여러 번의 readData() 호출에 걸쳐 이벤트가 나뉘어도 올바르게 묶이도록 상태를 유지합니다.
+ */
+struct CoincidenceCounter {
+    uint64_t window_ps = 100000;
+    uint64_t event_start = 0;
+    unsigned channel_mask = 0;
+    bool has_event = false;
+
+    void add(unsigned channel, uint64_t timestamp_ps, ScanPoint& point) {
+        if (has_event && timestamp_ps - event_start > window_ps) flush(point);
+        if (!has_event) {
+            event_start = timestamp_ps;
+            has_event = true;
+        }
+        channel_mask |= 1u << (channel - 1);
+        point.singles[channel - 1]++;
+    }
+
+    void flush(ScanPoint& point) {
+        if (has_event && __builtin_popcount(channel_mask) >= 2) {
+            point.coincidence_events++;
+            for (int ch = 0; ch < 4; ++ch) {
+                if (channel_mask & (1u << ch)) point.coincident[ch]++;
+            }
+        }
+        channel_mask = 0;
+        has_event = false;
+    }
+};
+
+// Ctrl+C 시그널 처리를 위한 전역 변수
+volatile sig_atomic_t g_signal_status = 0;
+void signal_handler(int signal) { g_signal_status = signal; }
+
+void print_usage(const char* prog_name) {
+    std::cerr << "Usage: " << prog_name << " -c <config.txt> -o <scan.txt> [-ip <ip_override>]\n"
+              << "       [-r <rel_precision=0.05>] [-dmin <sec=0.2>] [-dmax <sec=2>]\n"
+              << "       [-from <1>] [-to <255>] [-s <step=1>] [-cw <coinc_window_ns=100>]\n"
+              << "       [-f <purity_fraction=0.9>] [-k <min_significance_sigma=5>] [-u (write suggested thresholds to config, skipped if aborted)]" << std::endl;
+}
+
+/// @brief 8바이트 raw 데이터 블록을 파싱하여 집계합니다.
+void accumulate(const std::vector<char>& data, int event_count, CoincidenceCounter& counter, ScanPoint& point) {
+    TdcHit hit;
+    for (int i = 0; i < event_count; ++i) {
+        hit.parse(&data[i * 8], i);
+        if (hit.channel >= 1 && hit.channel <= 4) {
+            counter.add(hit.channel, hit.timestamp, point);
+        }
+    }
+}
+
+/// @brief 하나의 임계값에서 목표 정밀도 또는 최대 dwell time에 도달할 때까지 데이터를 수집합니다.
+ScanPoint measure_point(TdcController& tdc, int threshold, long target_counts,
+                        double min_dwell, double max_dwell, uint64_t window_ps) {
+    ScanPoint point;
+    point.threshold = threshold;
+    CoincidenceCounter counter;
+    counter.window_ps = window_ps;
+
+    tdc.setThresholds({threshold, threshold, threshold, threshold});
+    tdc.reset();
+    tdc.start();
+    auto t_start = std::chrono::steady_clock::now();
+
+    while (!g_signal_status) {
+        int data_size = tdc.getDataSize();
+        if (data_size >= DATA_SIZE_MAX) point.saturated = true;
+        if (data_size > 0) {
+            auto data_buffer = tdc.readData(data_size);
+            accumulate(data_buffer, data_size, counter, point);
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+        long min_counts = *std::min_element(point.singles.begin(), point.singles.end());
+        if (elapsed >= max_dwell || (elapsed >= min_dwell && min_counts >= target_counts)) break;
+        if (data_size == 0) usleep(5000);
+    }
+
+    tdc.stop();
+    point.dwell_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+
+    // 정지 후 버퍼에 남은 데이터까지 모두 집계 (다음 지점의 reset()이 버퍼를 비우므로 rate가 낮게 측정되지 않도록)
+    int data_size;
+    while ((data_size = tdc.getDataSize()) > 0) {
+        if (data_size >= DATA_SIZE_MAX) point.saturated = true;
+        auto data_buffer = tdc.readData(data_size);
+        accumulate(data_buffer, data_size, counter, point);
+    }
+    counter.flush(point);
+    return point;
+}
+
+/**
+ * @brief 채널 ch의 hit 중 다른 채널의 무상관 hit과 우연히 같은 이벤트로 묶일 것으로 예상되는 수를 계산합니다.
+ *
+ * 다른 채널의 rate 합을 R 이라 하면, 한 hit 주변 약 2*window 안에 다른 채널 hit이 하나 이상 있을 확률은
+ * 1 - exp(-2 * window * R) 입니다. (rate가 낮으면 2 * window * R_i * R_j 근사와 같고, 노이즈 영역에서는 1로 포화)
+ */
+double accidental_coincident(const ScanPoint& p, int ch, double window_sec) {
+    double other_rate = 0.0;
+    for (int j = 0; j < 4; ++j) {
+        if (j != ch) other_rate += p.singles[j] / p.dwell_sec;
+    }
+    return p.singles[ch] * (1.0 - std::exp(-2.0 * window_sec * other_rate));
+}
+
+/// @brief 우연 coincidence를 넘는 초과분의 유의도를 coincident 수의 포아송 오차(sqrt(N)) 단위로 반환합니다.
+double excess_significance(const ScanPoint& p, int ch, double window_sec) {
+    if (p.coincident[ch] <= 0) return 0.0;
+    return (p.coincident[ch] - accidental_coincident(p, ch, window_sec)) / std::sqrt(static_cast<double>(p.coincident[ch]));
+}
+
+/**
+ * @brief 채널별 추천 임계값을 계산합니다.
+ * @param min_significance 초과분이 이 값(sigma) 이하인 지점은 무시합니다. 읽기가 포화된 지점도 무시합니다.
+ * @param significance 추천 지점의 유의도 (출력)
+ * @return 추천 임계값. 유의한 초과 coincidence가 있는 지점이 없는 채널은 -1을 반환합니다.
+ */
+int suggest_threshold(const std::vector<ScanPoint>& scan, int ch, long min_counts, double purity_fraction,
+                      double window_sec, double min_significance, double& significance) {
+    auto usable = [&](const ScanPoint& p) {
+        return !p.saturated && p.singles[ch] >= min_counts && excess_significance(p, ch, window_sec) > min_significance;
+    };
+    auto purity = [&](const ScanPoint& p) {
+        return (p.coincident[ch] - accidental_coincident(p, ch, window_sec)) / p.singles[ch];
+    };
+
+    double max_purity = 0.0;
+    for (const auto& p : scan) {
+        if (usable(p)) max_purity = std::max(max_purity, purity(p));
+    }
+    if (max_purity <= 0.0) return -1;
+
+    for (const auto& p : scan) {
+        if (usable(p) && purity(p) >= purity_fraction * max_purity) {
+            significance = excess_significance(p, ch, window_sec);
+            return p.threshold;
+        }
+    }
+    return -1;
+}
+
+/// @brief 설정 파일의 임계값 4줄을 새 값으로 교체합니다. (주석과 IP 줄은 그대로 유지)
+bool write_thresholds(const std::string& config_filename, const std::array<int, 4>& thresholds) {
+    std::ifstream infile(config_filename);
+    if (!infile.is_open()) return false;
+
+    std::vector<std::string> lines;
+    std::string line;
+    bool ip_found = false;
+    int replaced = 0;
+    while (std::getline(infile, line)) {
+        if (!line.empty() && line[0] != '#') {
+            if (!ip_found) {
+                ip_found = true;
+            } else if (replaced < 4) {
+                size_t begin = line.find_first_not_of(" \t");
+                size_t end = line.find_first_not_of("0123456789", begin);
+                if (begin != std::string::npos && end != begin) {
+                    line = line.substr(0, begin) + std::to_string(thresholds[replaced]) +
+                           (end == std::string::npos ? "" : line.substr(end));
+                    replaced++;
+                }
+            }
+        }
+        lines.push_back(line);
+    }
+    infile.close();
+    if (replaced < 4) return false;
+
+    std::ofstream outfile(config_filename);
+    if (!outfile.is_open()) return false;
+    for (const auto& l : lines) outfile << l << '\n';
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::string ip_addr, out_filename, config_filename;
+    double rel_precision = 0.05;
+    double min_dwell = 0.2, max_dwell = 2.0;
+    int thr_from = 1, thr_to = 255, thr_step = 1;
+    int coinc_window_ns = 100;
+    double purity_fraction = 0.9;
+    double min_significance = 5.0;
+    bool update_config = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "-u") { update_config = true; continue; }
+            if (i + 1 >= argc) { print_usage(argv[0]); return 1; }
+            if (arg == "-o") out_filename = argv[++i];
+            else if (arg == "-c") config_filename = argv[++i];
+            else if (arg == "-ip") ip_addr = argv[++i];
+            else if (arg == "-r") rel_precision = std::stod(argv[++i]);
+            else if (arg == "-dmin") min_dwell = std::stod(argv[++i]);
+            else if (arg == "-dmax") max_dwell = std::stod(argv[++i]);
+            else if (arg == "-from") thr_from = std::stoi(argv[++i]);
+            else if (arg == "-to") thr_to = std::stoi(argv[++i]);
+            else if (arg == "-s") thr_step = std::stoi(argv[++i]);
+            else if (arg == "-cw") coinc_window_ns = std::stoi(argv[++i]);
+            else if (arg == "-f") purity_fraction = std::stod(argv[++i]);
+            else if (arg == "-k") min_significance = std::stod(argv[++i]);
+            else { print_usage(argv[0]); return 1; }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Invalid option value." << std::endl;
+        return 1;
+    }
+
+    if (out_filename.empty() || config_filename.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    thr_from = std::clamp(thr_from, 1, 255);
+    thr_to = std::clamp(thr_to, thr_from, 255);
+    if (thr_step < 1 || rel_precision <= 0.0 || max_dwell < min_dwell) {
+        std::cerr << "Error: step must be >= 1, precision > 0 and dmax >= dmin." << std::endl;
+        return 1;
+    }
+
+    // --- 설정 파일 파싱 (frontend_tdc_mini와 동일한 포맷) ---
+    std::ifstream config_file(config_filename);
+    if (!config_file.is_open()) {
+        std::cerr << "Error: Could not open config file: " << config_filename << std::endl;
+        return 1;
+    }
+
+    std::string line;
+    std::string config_ip;
+    std::vector<int> thresholds;
+
+    while (std::getline(config_file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        config_ip = line;
+        break;
+    }
+    while (std::getline(config_file, line) && thresholds.size() < 4) {
+        if (line.empty() || line[0] == '#') continue;
+        std::stringstream ss(line);
+        int thr;
+        if (ss >> thr) thresholds.push_back(thr);
+    }
+    config_file.close();
+
+    if (ip_addr.empty()) ip_addr = config_ip;
+
+    if (ip_addr.empty() || thresholds.size() < 4) {
+        std::cerr << "Error: Invalid config file format. IP address and 4 thresholds are required." << std::endl;
+        return 1;
+    }
+
+    // 목표 상대 정밀도 r 을 얻기 위해 필요한 hit 수: 1/sqrt(N) <= r  ->  N >= 1/r^2
+    const long target_counts = static_cast<long>(std::ceil(1.0 / (rel_precision * rel_precision)));
+    const uint64_t window_ps = static_cast<uint64_t>(coinc_window_ns) * 1000;
+    const double window_sec = coinc_window_ns * 1e-9;
+
+    std::vector<ScanPoint> scan;
+    TdcController tdc;
+    try {
+        tdc.connect(ip_addr);
+        tdc.initializeTdc();
+        tdc.setAcquisitionTime(0);
+
+        signal(SIGINT, signal_handler);
+        std::cout << "Threshold scan " << thr_from << " -> " << thr_to << " (step " << thr_step
+                  << "), target " << target_counts << " hits/channel, dwell "
+                  << min_dwell << "-" << max_dwell << " s. Press Ctrl+C to abort." << std::endl;
+
+        for (int thr = thr_from; thr <= thr_to && !g_signal_status; thr += thr_step) {
+            scan.push_back(measure_point(tdc, thr, target_counts, min_dwell, max_dwell, window_ps));
+            const auto& p = scan.back();
+            printf("THR %3d | %5.2f s | CH1 %8.1f Hz | CH2 %8.1f Hz | CH3 %8.1f Hz | CH4 %8.1f Hz | COINC %7.2f Hz%s\r",
+                   p.threshold, p.dwell_sec,
+                   p.singles[0] / p.dwell_sec, p.singles[1] / p.dwell_sec,
+                   p.singles[2] / p.dwell_sec, p.singles[3] / p.dwell_sec,
+                   p.coincidence_events / p.dwell_sec, p.saturated ? " | SATURATED" : "");
+            fflush(stdout);
+        }
+        std::cout << std::endl;
+
+        // 스캔이 끝나면 원래 설정값으로 복원
+        tdc.setThresholds({thresholds[0], thresholds[1], thresholds[2], thresholds[3]});
+    } catch (const std::exception& e) {
+        std::cerr << "An error occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    long saturated_points = std::count_if(scan.begin(), scan.end(), [](const ScanPoint& p) { return p.saturated; });
+    if (saturated_points > 0) {
+        std::cout << "Warning: readout backlog reached " << DATA_SIZE_MAX << " events at " << saturated_points
+                  << " points; their rates are not reliable and they are excluded from the suggestion." << std::endl;
+    }
+
+    if (g_signal_status) {
+        std::cout << "Scan aborted by user after " << scan.size() << " points." << std::endl;
+    }
+
+    // --- 결과 저장: 임계값별 rate 곡선 (단위: Hz, 오차는 포아송 통계) ---
+    std::ofstream outfile(out_filename);
+    if (!outfile.is_open()) {
+        std::cerr << "Error: Could not open output file: " << out_filename << std::endl;
+        return 1;
+    }
+    outfile << "# threshold dwell_s";
+    for (int ch = 1; ch <= 4; ++ch) outfile << " ch" << ch << "_rate ch" << ch << "_err";
+    for (int ch = 1; ch <= 4; ++ch) outfile << " ch" << ch << "_coinc_rate ch" << ch << "_coinc_err";
+    for (int ch = 1; ch <= 4; ++ch) outfile << " ch" << ch << "_accidental_rate";
+    for (int ch = 1; ch <= 4; ++ch) outfile << " ch" << ch << "_excess_sigma";
+    outfile << " coinc_rate coinc_err saturated\n";
+    for (const auto& p : scan) {
+        outfile << p.threshold << ' ' << p.dwell_sec;
+        for (int ch = 0; ch < 4; ++ch) {
+            outfile << ' ' << p.singles[ch] / p.dwell_sec << ' ' << std::sqrt(static_cast<double>(p.singles[ch])) / p.dwell_sec;
+        }
+        for (int ch = 0; ch < 4; ++ch) {
+            outfile << ' ' << p.coincident[ch] / p.dwell_sec << ' ' << std::sqrt(static_cast<double>(p.coincident[ch])) / p.dwell_sec;
+        }
+        for (int ch = 0; ch < 4; ++ch) {
+            outfile << ' ' << accidental_coincident(p, ch, window_sec) / p.dwell_sec;
+        }
+        for (int ch = 0; ch < 4; ++ch) {
+            outfile << ' ' << excess_significance(p, ch, window_sec);
+        }
+        outfile << ' ' << p.coincidence_events / p.dwell_sec << ' '
+                << std::sqrt(static_cast<double>(p.coincidence_events)) / p.dwell_sec << ' ' << p.saturated << '\n';
+    }
+
+    // --- 추천 임계값 계산 ---
+    // 통계가 부족한 지점(목표 hit 수의 1/4 미만)은 coincidence 비율 계산에서 제외
+    std::array<int, 4> suggested{};
+    outfile << "# suggested thresholds:";
+    for (int ch = 0; ch < 4; ++ch) {
+        double significance = 0.0;
+        int thr = suggest_threshold(scan, ch, std::max(1L, target_counts / 4), purity_fraction,
+                                    window_sec, min_significance, significance);
+        if (thr < 0) {
+            std::cout << "CH" << ch + 1 << ": no coincidences above accidentals with > " << min_significance
+                      << " sigma, keeping " << thresholds[ch] << std::endl;
+            thr = thresholds[ch];
+        } else {
+            printf("CH%d: suggested threshold %d (excess over accidentals %.1f sigma)\n", ch + 1, thr, significance);
+        }
+        suggested[ch] = thr;
+        outfile << ' ' << thr;
+    }
+    outfile << '\n';
+    outfile.close();
+    std::cout << "Rate curves saved to " << out_filename << std::endl;
+
+    if (update_config && g_signal_status) {
+        std::cout << "Scan was aborted; " << config_filename << " is left unchanged." << std::endl;
+    } else if (update_config) {
+        if (!write_thresholds(config_filename, suggested)) {
+            std::cerr << "Error: Could not update thresholds in " << config_filename << std::endl;
+            return 1;
+        }
+        std::cout << "Suggested thresholds written to " << config_filename << std::endl;
+    }
+    return 0;
+}
@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 
 #include "TFile.h"
 #include "TTreeReader.h"
@@ -10,8 +11,9 @@
 #include "TCanvas.h"
 #include "TApplication.h"
 #include "TStyle.h"
+#include "TdcCalibration.h"
 
-void tdc_viewer(const std::string& filename) {
+void tdc_viewer(const std::string& filename, const std::string& lut_index) {
     TFile* file = TFile::Open(filename.c_str(), "READ");
     if (!file || file->IsZombie()) {
         std::cerr << "Error: Cannot open file " << filename << std::endl;
@@ -36,6 +38,19 @@ void tdc_viewer(const std::string& filename) {
         h_tdc[i] = new TH1F(Form("h_tdc_ch%d", i+1), Form("TDC Spectrum CH%d;TDC Value;Counts", i+1), 4096, -0.5, 4095.5);
     }
     
+    // 버전별 LUT(LutDriftMonitor 출력)가 주어지면 hit 시간에 맞는 LUT로 보정한 스펙트럼도 생성
+    std::unique_ptr<LutTimeline> luts;
+    TH1F* h_tdc_cal[4] = {nullptr, nullptr, nullptr, nullptr};
+    if (!lut_index.empty()) {
+        luts = std::make_unique<LutTimeline>();
+        luts->load(lut_index);
+        luts->checkEntries(static_cast<uint64_t>(reader.GetEntries()));
+        std::cout << "Loaded " << luts->size() << " LUT snapshots from " << lut_index << std::endl;
+        for(int i=0; i<4; ++i) {
+            h_tdc_cal[i] = new TH1F(Form("h_tdc_cal_ch%d", i+1), Form("Calibrated TDC CH%d;Calibrated TDC;Counts", i+1), 1002, -0.5, 1001.5);
+        }
+    }
+    
     // 시간 차이 히스토그램 (단위: ps)
     TH1F* h_time_diff = new TH1F("h_time_diff", "Time Difference (CH2 - CH1);Time (ps);Counts", 2000, -10000, 10000);
 
@@ -47,6 +62,7 @@ void tdc_viewer(const std::string& filename) {
         h_hits->Fill(*channel);
         if (*channel >= 1 && *channel <= 4) {
             h_tdc[*channel - 1]->Fill(*tdc);
+            if (luts) h_tdc_cal[*channel - 1]->Fill(luts->calibrate(*channel, *tdc, reader.GetCurrentEntry()));
         }
 
         // CH1과 CH2의 시간 차이 계산
@@ -75,16 +91,32 @@ void tdc_viewer(const std::string& filename) {
     c2->cd();
     h_time_diff->Draw();
 
+    if (luts) {
+        TCanvas* c3 = new TCanvas("c3", "Calibrated TDC Spectra", 1200, 800);
+        c3->Divide(2, 2);
+        for(int i=0; i<4; ++i) {
+            c3->cd(i + 1);
+            h_tdc_cal[i]->Draw();
+        }
+    }
+
     std::cout << "Displaying canvases. Close all ROOT windows to exit." << std::endl;
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <input.root>" << std::endl;
+    if ((argc != 2 && argc != 4) || (argc == 4 && std::string(argv[2]) != "-l")) {
+        std::cerr << "Usage: " << argv[0] << " <input.root> [-l <lut_prefix.idx>]" << std::endl;
         return 1;
     }
+    std::string filename = argv[1];
+    std::string lut_index = (argc == 4) ? argv[3] : "";
     TApplication app("App", &argc, argv);
-    tdc_viewer(argv[1]);
+    try {
+        tdc_viewer(filename, lut_index);
+    } catch (const std::exception& e) {
+        std::cerr << "An error occurred: " << e.what() << std::endl;
+        return 1;
+    }
     app.Run();
     return 0;
 }
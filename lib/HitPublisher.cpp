@@ -0,0 +1,220 @@
+#include "HitPublisher.h"
+#include "TdcController.h"
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+/// @brief 헤더와 payload를 한 번의 sendmsg로 전송합니다. (부분 전송 시 남은 부분을 이어서 전송)
+bool send_batch(int fd, const HitBatchHeader& header, const std::vector<char>& payload) {
+    iovec iov[2];
+    iov[0].iov_base = const_cast<HitBatchHeader*>(&header);
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = const_cast<char*>(payload.data());
+    iov[1].iov_len = static_cast<size_t>(header.hit_count) * 8;
+
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+    while (msg.msg_iovlen > 0) {
+        ssize_t sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        // 전송된 만큼 iovec을 앞으로 이동
+        while (msg.msg_iovlen > 0 && static_cast<size_t>(sent) >= msg.msg_iov[0].iov_len) {
+            sent -= msg.msg_iov[0].iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+        if (msg.msg_iovlen > 0) {
+            msg.msg_iov[0].iov_base = static_cast<char*>(msg.msg_iov[0].iov_base) + sent;
+            msg.msg_iov[0].iov_len -= sent;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+HitPublisher::HitPublisher(const std::string& socket_path, size_t queue_depth)
+    : m_socket_path(socket_path), m_queue_depth(std::max<size_t>(queue_depth, 1)) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(addr.sun_path)) {
+        throw TdcError("Invalid stream socket path: " + socket_path);
+    }
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    // 이전 실행에서 남은 소켓 파일만 제거 (일반 파일이나 다른 발행자가 사용 중인 소켓은 건드리지 않음)
+    struct stat st{};
+    if (lstat(socket_path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            throw TdcError("Refusing to replace non-socket file: " + socket_path);
+        }
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        bool in_use = probe >= 0 && ::connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        if (probe >= 0) close(probe);
+        if (in_use) {
+            throw TdcError("Stream socket is already in use by another publisher: " + socket_path);
+        }
+        unlink(socket_path.c_str());
+    }
+
+    m_listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listen_fd < 0) {
+        throw TdcError("Stream socket creation failed: " + std::string(strerror(errno)));
+    }
+    if (bind(m_listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(m_listen_fd, 8) < 0) {
+        std::string reason = strerror(errno);
+        close(m_listen_fd);
+        throw TdcError("Stream socket bind/listen failed: " + reason);
+    }
+
+    m_acceptor = std::thread(&HitPublisher::acceptLoop, this);
+}
+
+HitPublisher::~HitPublisher() {
+    m_stop = true;
+    if (m_acceptor.joinable()) m_acceptor.join();
+
+    std::lock_guard<std::mutex> lock(m_subscribers_mutex);
+
+    // 1. 각 큐의 끝에 스트림 종료 헤더(hit_count 0)를 넣고, 남은 배치를 모두 보내도록 함
+    HitBatchHeader end_of_stream;
+    end_of_stream.sequence = m_sequence;
+    const auto empty = std::make_shared<const std::vector<char>>();
+    for (auto& sub : m_subscribers) {
+        std::lock_guard<std::mutex> sub_lock(sub->mutex);
+        if (sub->closing) continue;
+        end_of_stream.dropped_batches = sub->dropped;
+        sub->queue.emplace_back(end_of_stream, empty);
+        sub->draining = true;
+        sub->cv.notify_one();
+    }
+
+    // 2. 제한 시간 안에 전송을 마치지 못한 구독자는 강제로 종료
+    const auto deadline = std::chrono::steady_clock::now() + DRAIN_TIMEOUT;
+    auto all_done = [this] {
+        return std::all_of(m_subscribers.begin(), m_subscribers.end(),
+                           [](const std::unique_ptr<Subscriber>& sub) { return sub->dead.load(); });
+    };
+    while (!all_done() && std::chrono::steady_clock::now() < deadline) {
+        usleep(10000);
+    }
+
+    for (auto& sub : m_subscribers) closeSubscriber(*sub);
+    m_subscribers.clear();
+
+    close(m_listen_fd);
+    unlink(m_socket_path.c_str());
+}
+
+void HitPublisher::publish(std::shared_ptr<const std::vector<char>> batch, uint64_t first_event_id) {
+    if (batch->size() < 8) return; // hit_count 0은 스트림 종료 표시로 예약됨
+
+    HitBatchHeader header;
+    header.hit_count = static_cast<uint32_t>(batch->size() / 8);
+    header.sequence = m_sequence++;
+    header.first_event_id = first_event_id;
+
+    std::lock_guard<std::mutex> lock(m_subscribers_mutex);
+    for (auto& sub : m_subscribers) {
+        std::lock_guard<std::mutex> sub_lock(sub->mutex);
+        if (sub->closing) continue;
+        if (sub->queue.size() >= m_queue_depth) {
+            if (sub->policy == StreamPolicy::Drop) {
+                sub->dropped++;
+            } else {
+                // Block 정책: 데이터 누락 대신 연결을 끊어 DAQ 루프가 멈추지 않도록 함
+                sub->closing = true;
+                shutdown(sub->fd, SHUT_RDWR);
+                sub->cv.notify_one();
+            }
+            continue;
+        }
+        header.dropped_batches = sub->dropped;
+        sub->queue.emplace_back(header, batch);
+        sub->cv.notify_one();
+    }
+}
+
+size_t HitPublisher::subscriberCount() {
+    reapDeadSubscribers();
+    std::lock_guard<std::mutex> lock(m_subscribers_mutex);
+    return m_subscribers.size();
+}
+
+void HitPublisher::acceptLoop() {
+    while (!m_stop) {
+        reapDeadSubscribers();
+
+        pollfd pfd{m_listen_fd, POLLIN, 0};
+        if (poll(&pfd, 1, 100) <= 0 || !(pfd.revents & POLLIN)) continue;
+
+        int fd = accept(m_listen_fd, nullptr, nullptr);
+        if (fd < 0) continue;
+
+        // 핸드셰이크: 구독자가 요청한 정책 1바이트 수신 (1초 이내)
+        pollfd hfd{fd, POLLIN, 0};
+        uint8_t policy = 0;
+        if (poll(&hfd, 1, 1000) <= 0 || read(fd, &policy, 1) != 1 ||
+            policy > static_cast<uint8_t>(StreamPolicy::Block)) {
+            close(fd);
+            continue;
+        }
+
+        auto sub = std::make_unique<Subscriber>();
+        sub->fd = fd;
+        sub->policy = static_cast<StreamPolicy>(policy);
+        Subscriber& ref = *sub;
+        std::lock_guard<std::mutex> lock(m_subscribers_mutex);
+        m_subscribers.push_back(std::move(sub));
+        ref.sender = std::thread(&HitPublisher::sendLoop, this, std::ref(ref));
+    }
+}
+
+void HitPublisher::sendLoop(Subscriber& sub) {
+    while (true) {
+        std::unique_lock<std::mutex> lock(sub.mutex);
+        sub.cv.wait(lock, [&sub] { return sub.closing || sub.draining || !sub.queue.empty(); });
+        if (sub.closing || sub.queue.empty()) break; // 강제 종료, 또는 종료 요청 후 큐를 모두 비움
+        auto item = std::move(sub.queue.front());
+        sub.queue.pop_front();
+        lock.unlock();
+
+        if (!send_batch(sub.fd, item.first, *item.second)) break; // 구독자 연결 해제
+    }
+    sub.dead = true;
+}
+
+void HitPublisher::reapDeadSubscribers() {
+    std::lock_guard<std::mutex> lock(m_subscribers_mutex);
+    auto it = std::remove_if(m_subscribers.begin(), m_subscribers.end(), [](const std::unique_ptr<Subscriber>& sub) {
+        if (!sub->dead) return false;
+        closeSubscriber(*sub);
+        return true;
+    });
+    m_subscribers.erase(it, m_subscribers.end());
+}
+
+void HitPublisher::closeSubscriber(Subscriber& sub) {
+    {
+        std::lock_guard<std::mutex> lock(sub.mutex);
+        sub.closing = true;
+        sub.queue.clear();
+    }
+    shutdown(sub.fd, SHUT_RDWR); // send()에서 대기 중인 전송 스레드를 깨움
+    sub.cv.notify_one();
+    if (sub.sender.joinable()) sub.sender.join();
+    close(sub.fd);
+}
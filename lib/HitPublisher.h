@@ -0,0 +1,79 @@
+#ifndef HIT_PUBLISHER_H
+#define HIT_PUBLISHER_H
+
+#include "HitStream.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class HitPublisher
+ * @brief DAQ 루프에서 읽은 hit 배치를 Unix-domain 소켓으로 여러 구독자에게 배포(fan-out)하는 클래스.
+ *
+ * 구독자는 실행 중 언제든지 접속/해제할 수 있습니다. 각 구독자는 전용 전송 스레드와 제한된 길이의 큐를 가지며,
+ * publish()는 배치의 shared_ptr을 각 큐에 넣기만 하므로 소켓 I/O 때문에 DAQ 루프가 멈추는 일은 없습니다.
+ * 하나의 배치 버퍼는 모든 구독자가 공유하며 복사되지 않습니다.
+ * 소멸 시에는 각 구독자의 큐에 남은 배치와 스트림 종료 헤더를 모두 전송한 뒤(최대 DRAIN_TIMEOUT) 연결을 닫습니다.
+ */
+class HitPublisher {
+public:
+    /// @brief 종료 시 구독자별 남은 배치 전송을 기다리는 최대 시간
+    static constexpr std::chrono::seconds DRAIN_TIMEOUT{5};
+
+    /**
+     * @param socket_path Unix-domain 소켓 경로. 이전 실행에서 남은 소켓 파일만 다시 생성하며,
+     * 소켓이 아닌 파일이 있거나 다른 발행자가 사용 중이면 TdcError를 던집니다.
+     * @param queue_depth 구독자별 최대 대기 배치 수.
+     */
+    explicit HitPublisher(const std::string& socket_path, size_t queue_depth = 256);
+    ~HitPublisher();
+
+    HitPublisher(const HitPublisher&) = delete;
+    HitPublisher& operator=(const HitPublisher&) = delete;
+
+    /**
+     * @brief 8바이트 raw 레코드 배치를 모든 구독자에게 발행합니다. (non-blocking)
+     * @param batch TDC에서 읽은 raw 데이터 (크기는 8의 배수)
+     * @param first_event_id 배치 첫 hit의 event_id
+     */
+    void publish(std::shared_ptr<const std::vector<char>> batch, uint64_t first_event_id);
+
+    /// @brief 현재 접속 중인 구독자 수를 반환합니다.
+    size_t subscriberCount();
+
+private:
+    struct Subscriber {
+        int fd = -1;
+        StreamPolicy policy = StreamPolicy::Drop;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<std::pair<HitBatchHeader, std::shared_ptr<const std::vector<char>>>> queue;
+        uint64_t dropped = 0;
+        bool closing = false;   // 즉시 종료 (남은 배치 폐기)
+        bool draining = false;  // 큐를 모두 보낸 뒤 종료
+        std::atomic<bool> dead{false};
+        std::thread sender;
+    };
+
+    std::string m_socket_path;
+    size_t m_queue_depth;
+    int m_listen_fd = -1;
+    uint64_t m_sequence = 0;
+    std::atomic<bool> m_stop{false};
+    std::thread m_acceptor;
+    std::mutex m_subscribers_mutex;
+    std::vector<std::unique_ptr<Subscriber>> m_subscribers;
+
+    void acceptLoop();
+    void sendLoop(Subscriber& sub);
+    void reapDeadSubscribers();
+    static void closeSubscriber(Subscriber& sub);
+};
+
+#endif // HIT_PUBLISHER_H
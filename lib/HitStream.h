@@ -0,0 +1,58 @@
+#ifndef HIT_STREAM_H
+#define HIT_STREAM_H
+
+#include <cstdint>
+
+/**
+ * @file HitStream.h
+ * @brief HitPublisher(frontend_tdc_mini)와 HitSubscriber(소비자 프로세스)가 공유하는 스트림 프로토콜 정의.
+ *
+ * 전송은 같은 호스트의 Unix-domain 스트림 소켓을 사용합니다.
+ * 1. 구독자는 접속 직후 StreamPolicy 1바이트를 전송합니다.
+ * 2. 발행자는 이후 배치마다 HitBatchHeader와 hit_count * 8 바이트의 TDC raw 데이터를 연속으로 전송합니다.
+ * 3. 발행자가 종료할 때는 큐에 남은 배치를 모두 보낸 뒤 hit_count가 0인 종료 헤더를 보냅니다.
+ *    종료 헤더의 sequence는 다음 배치 번호이므로, 마지막 배치 이후에 버려진 배치도 번호 차이로 알 수 있습니다.
+ * raw 데이터는 TDC에서 읽은 버퍼를 복사 없이 그대로 전달하며, 디코딩은 구독자 측에서 수행합니다.
+ */
+
+/// @brief 느린 구독자에 대한 처리 정책. 어떤 정책이든 DAQ 루프는 멈추지 않습니다.
+enum class StreamPolicy : uint8_t {
+    /// 구독자 큐가 가득 차면 새 배치를 버립니다. 버려진 배치는 sequence 번호의 차이로 알 수 있습니다.
+    Drop = 0,
+    /// 배치를 하나도 빠뜨리지 않고 전송합니다. (DAQ 종료 시 남은 배치 포함) 큐가 가득 찰 만큼 뒤처지면 연결을 끊습니다.
+    Block = 1
+};
+
+/// @brief 배치 헤더 (호스트 바이트 순서, 32바이트)
+struct HitBatchHeader {
+    static constexpr uint32_t MAGIC = 0x54444348; // "TDCH"
+
+    uint32_t magic = MAGIC;
+    uint32_t hit_count = 0;       // 뒤따르는 8바이트 hit 레코드 수 (0이면 스트림 종료)
+    uint64_t sequence = 0;        // 발행자 전역 배치 번호 (구독자별로 건너뛴 번호가 있으면 drop 발생)
+    uint64_t first_event_id = 0;  // 배치 첫 hit의 event_id (frontend TTree의 event_id와 동일)
+    uint64_t dropped_batches = 0; // 이 헤더를 큐에 넣을 때까지 이 구독자에 대해 버려진 배치 수
+};
+static_assert(sizeof(HitBatchHeader) == 32, "HitBatchHeader must be 32 bytes");
+
+/// @brief 디코딩된 TDC hit (frontend_tdc_mini의 TdcEvent와 동일한 의미)
+struct TdcHit {
+    uint32_t event_id = 0;
+    uint32_t channel = 0;
+    uint32_t tdc = 0;
+    uint64_t timestamp = 0; // ps 단위
+
+    /// @brief 8바이트 TDC raw 레코드를 파싱합니다. (LSB first, timestamp는 8ps 단위 -> ps 변환)
+    void parse(const char* buffer, uint32_t id) {
+        event_id = id;
+        tdc = (static_cast<uint8_t>(buffer[1]) << 8) | static_cast<uint8_t>(buffer[0]);
+        timestamp = 0;
+        for (int i = 0; i < 5; ++i) {
+            timestamp |= static_cast<uint64_t>(static_cast<uint8_t>(buffer[i + 2])) << (i * 8);
+        }
+        timestamp *= 8;
+        channel = static_cast<uint8_t>(buffer[7]);
+    }
+};
+
+#endif // HIT_STREAM_H
@@ -0,0 +1,111 @@
+#include "HitSubscriber.h"
+#include "TdcController.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+HitSubscriber::HitSubscriber() : m_socket_handle(-1) {}
+
+HitSubscriber::~HitSubscriber() {
+    if (isConnected()) {
+        disconnect();
+    }
+}
+
+void HitSubscriber::connect(const std::string& socket_path, StreamPolicy policy) {
+    if (isConnected()) {
+        disconnect();
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(addr.sun_path)) {
+        throw TdcError("Invalid stream socket path: " + socket_path);
+    }
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    m_socket_handle = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_socket_handle < 0) {
+        throw TdcError("Stream socket creation failed");
+    }
+
+    if (::connect(m_socket_handle, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::string reason = strerror(errno);
+        disconnect();
+        throw TdcError("Connection to hit stream failed: " + reason);
+    }
+
+    m_has_sequence = false;
+    m_stream_ended = false;
+    m_missed_batches = 0;
+
+    const uint8_t policy_byte = static_cast<uint8_t>(policy);
+    if (send(m_socket_handle, &policy_byte, 1, MSG_NOSIGNAL) != 1) {
+        disconnect();
+        throw TdcError("Hit stream handshake failed");
+    }
+}
+
+void HitSubscriber::disconnect() {
+    if (isConnected()) {
+        close(m_socket_handle);
+        m_socket_handle = -1;
+    }
+}
+
+bool HitSubscriber::isConnected() const {
+    return m_socket_handle != -1;
+}
+
+bool HitSubscriber::receiveAll(char* buffer, size_t length) {
+    size_t total_read = 0;
+    while (total_read < length) {
+        ssize_t bytes_read = read(m_socket_handle, buffer + total_read, length - total_read);
+        if (bytes_read < 0 && errno == EINTR) continue;
+        if (bytes_read < 0) throw TdcError("Hit stream receive failed: " + std::string(strerror(errno)));
+        if (bytes_read == 0) return false;
+        total_read += bytes_read;
+    }
+    return true;
+}
+
+bool HitSubscriber::receive(std::vector<TdcHit>& hits) {
+    if (!isConnected()) throw TdcError("Not connected to hit stream");
+
+    if (!receiveAll(reinterpret_cast<char*>(&m_header), sizeof(m_header))) {
+        disconnect();
+        return false;
+    }
+    if (m_header.magic != HitBatchHeader::MAGIC) {
+        disconnect();
+        throw TdcError("Corrupted hit stream header");
+    }
+
+    // 건너뛴 sequence 번호 = 발행자가 이 구독자에 대해 버린 배치
+    if (m_has_sequence && m_header.sequence > m_next_sequence) {
+        m_missed_batches += m_header.sequence - m_next_sequence;
+    }
+    m_next_sequence = m_header.sequence + 1;
+    m_has_sequence = true;
+
+    if (m_header.hit_count == 0) { // 스트림 종료 헤더
+        m_stream_ended = true;
+        hits.clear();
+        disconnect();
+        return false;
+    }
+
+    m_raw.resize(static_cast<size_t>(m_header.hit_count) * 8);
+    if (!receiveAll(m_raw.data(), m_raw.size())) {
+        disconnect();
+        return false;
+    }
+
+    hits.resize(m_header.hit_count);
+    for (uint32_t i = 0; i < m_header.hit_count; ++i) {
+        hits[i].parse(&m_raw[i * 8], static_cast<uint32_t>(m_header.first_event_id + i));
+    }
+    return true;
+}
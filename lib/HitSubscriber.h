@@ -0,0 +1,57 @@
+#ifndef HIT_SUBSCRIBER_H
+#define HIT_SUBSCRIBER_H
+
+#include "HitStream.h"
+#include <string>
+#include <vector>
+
+/**
+ * @class HitSubscriber
+ * @brief frontend_tdc_mini의 HitPublisher에 접속하여 디코딩된 hit 배치를 받는 클라이언트 클래스.
+ *
+ * TdcController와 마찬가지로 RAII 패턴을 따르며, 객체 소멸 시 자동으로 연결을 해제합니다.
+ * 통신 오류는 TdcError 예외로 보고됩니다.
+ */
+class HitSubscriber {
+public:
+    HitSubscriber();
+    ~HitSubscriber();
+
+    HitSubscriber(const HitSubscriber&) = delete;
+    HitSubscriber& operator=(const HitSubscriber&) = delete;
+
+    /// @brief 발행자의 Unix-domain 소켓에 접속하고 느린 구독자 정책을 등록합니다.
+    void connect(const std::string& socket_path, StreamPolicy policy = StreamPolicy::Drop);
+    /// @brief 연결을 해제합니다.
+    void disconnect();
+    /// @brief 연결 상태를 확인합니다.
+    bool isConnected() const;
+
+    /**
+     * @brief 다음 배치를 받을 때까지 대기한 후 디코딩하여 hits에 채웁니다.
+     * @param hits 출력 버퍼 (재사용 시 메모리 재할당 없음)
+     * @return 배치를 받았으면 true, 스트림 종료 헤더를 받았거나 발행자가 연결을 종료했으면 false.
+     */
+    bool receive(std::vector<TdcHit>& hits);
+
+    /// @brief 마지막으로 받은 배치의 헤더를 반환합니다.
+    const HitBatchHeader& lastHeader() const { return m_header; }
+    /// @brief 접속 이후 받지 못한 배치 수를 반환합니다. (sequence 번호의 차이로 계산, 종료 헤더까지 반영)
+    uint64_t droppedBatches() const { return m_missed_batches; }
+    /// @brief 발행자의 정상 종료 헤더를 받았으면 true. (false이면 Block 정책 초과 등으로 연결이 끊긴 것)
+    bool streamEnded() const { return m_stream_ended; }
+
+private:
+    int m_socket_handle = -1;
+    HitBatchHeader m_header;
+    std::vector<char> m_raw; // 수신용 raw 버퍼 (재사용)
+    uint64_t m_next_sequence = 0;
+    uint64_t m_missed_batches = 0;
+    bool m_has_sequence = false;
+    bool m_stream_ended = false;
+
+    /// @brief length 바이트를 모두 받으면 true, 받기 전에 연결이 끊기면 false.
+    bool receiveAll(char* buffer, size_t length);
+};
+
+#endif // HIT_SUBSCRIBER_H
@@ -0,0 +1,210 @@
+#include "TdcCalibration.h"
+#include "TdcController.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <sstream>
+
+void computeLut(const std::vector<long>& hist, std::vector<short>& lut) {
+    double cnt_all = std::accumulate(hist.begin(), hist.end(), 0.0);
+    if (cnt_all <= 0.0) return;
+
+    lut.resize(TDC_CODES);
+    double bin_begin = 0.0, bin_end = 0.0;
+    double cnt_begin = 0.0, cnt_end = 0.0;
+
+    for (int i = 0; i < TDC_CODES; ++i) {
+        cnt_end += hist[TDC_CODES - 1 - i];
+        bin_end += ((cnt_end - cnt_begin) / cnt_all * 1000.0);
+        lut[TDC_CODES - 1 - i] = static_cast<short>((bin_end + bin_begin) / 2.0 + 0.5);
+        cnt_begin = cnt_end;
+        bin_begin = bin_end;
+    }
+    lut[0] = 0;
+    for (int i = 1; i < TDC_CODES; ++i) lut[i] += 1;
+}
+
+LutDriftMonitor::LutDriftMonitor(const std::string& prefix, int window_sec, int windows_per_lut, long min_counts)
+    : m_prefix(prefix), m_window_sec(window_sec), m_windows_per_lut(windows_per_lut), m_min_counts(min_counts) {
+    if (window_sec <= 0) throw TdcError("LUT window length must be at least 1 second");
+    if (windows_per_lut <= 0) throw TdcError("Number of windows per LUT must be at least 1");
+
+    for (int ch = 0; ch < TDC_CHANNELS; ++ch) {
+        m_window_hist[ch].assign(TDC_CODES, 0);
+        m_sum[ch].assign(TDC_CODES, 0);
+        // 통계가 쌓이기 전까지는 균일 분포(선형) LUT를 사용
+        computeLut(Histogram(TDC_CODES, 1), m_lut[ch]);
+    }
+
+    m_index.open(m_prefix + ".idx");
+    if (!m_index.is_open()) throw TdcError("Cannot open LUT index file " + m_prefix + ".idx");
+    m_index << "# version first_entry end_entry unix_begin unix_end stat_unix_begin"
+               " ch1_hits ch2_hits ch3_hits ch4_hits file\n" << std::flush;
+
+    m_start = Clock::now();
+    startWindow(0);
+}
+
+LutDriftMonitor::~LutDriftMonitor() {
+    finish();
+}
+
+void LutDriftMonitor::update() noexcept {
+    if (!m_enabled || m_finished) return;
+    const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(Clock::now() - m_start).count();
+    const uint64_t window_index = static_cast<uint64_t>(elapsed) / m_window_sec;
+    if (window_index == m_window_index) return;
+
+    try {
+        closeWindow();
+    } catch (const std::exception& e) {
+        // 캘리브레이션 부가 기능의 오류로 데이터 획득이 중단되지 않도록 모니터만 비활성화
+        std::cerr << "\nLUT drift monitor disabled: " << e.what() << std::endl;
+        m_enabled = false;
+    }
+    startWindow(window_index);
+}
+
+void LutDriftMonitor::finish() noexcept {
+    if (m_finished) return;
+    m_finished = true;
+    if (!m_enabled) return;
+    try {
+        closeWindow();
+    } catch (const std::exception& e) {
+        std::cerr << "\nLUT drift monitor: last snapshot not written: " << e.what() << std::endl;
+        m_enabled = false;
+    }
+}
+
+void LutDriftMonitor::startWindow(uint64_t window_index) {
+    m_window_index = window_index;
+    m_window_first_entry = m_entries;
+    m_window_unix_begin = static_cast<long long>(std::time(nullptr));
+}
+
+void LutDriftMonitor::closeWindow() {
+    if (m_window_hits == 0) return;
+
+    // 1. sliding sum에 현재 창을 더하고 기록에 보관
+    for (int ch = 0; ch < TDC_CHANNELS; ++ch) {
+        for (int code = 0; code < TDC_CODES; ++code) {
+            m_sum[ch][code] += m_window_hist[ch][code];
+            m_sum_hits[ch] += m_window_hist[ch][code];
+        }
+    }
+    m_history.push_back(m_window_hist);
+    m_history_index.push_back(m_window_index);
+    m_history_unix_begin.push_back(m_window_unix_begin);
+    for (auto& hist : m_window_hist) std::fill(hist.begin(), hist.end(), 0);
+    m_window_hits = 0;
+
+    // 2. 최근 windows_per_lut 개 창 범위를 벗어난 오래된 창을 sliding sum에서 제거
+    while (!m_history.empty() && m_history_index.front() + m_windows_per_lut <= m_window_index) {
+        for (int ch = 0; ch < TDC_CHANNELS; ++ch) {
+            for (int code = 0; code < TDC_CODES; ++code) {
+                m_sum[ch][code] -= m_history.front()[ch][code];
+                m_sum_hits[ch] -= m_history.front()[ch][code];
+            }
+        }
+        m_history.pop_front();
+        m_history_index.pop_front();
+        m_history_unix_begin.pop_front();
+    }
+
+    // 3. 통계가 충분한 채널만 LUT 갱신
+    for (int ch = 0; ch < TDC_CHANNELS; ++ch) {
+        if (m_sum_hits[ch] >= m_min_counts) computeLut(m_sum[ch], m_lut[ch]);
+    }
+
+    // 4. 스냅샷 저장 (tdc_calibrator와 동일한 포맷) 및 인덱스 기록
+    char suffix[24];
+    std::snprintf(suffix, sizeof(suffix), "_v%04d.lut", m_version + 1);
+    const std::string lut_filename = m_prefix + suffix;
+    std::ofstream outfile(lut_filename, std::ios::binary);
+    if (!outfile.is_open()) throw TdcError("Cannot open LUT snapshot file " + lut_filename);
+    for (const auto& lut : m_lut) {
+        outfile.write(reinterpret_cast<const char*>(lut.data()), TDC_CODES * sizeof(short));
+    }
+    outfile.close();
+    if (!outfile) throw TdcError("Cannot write LUT snapshot file " + lut_filename);
+    m_version++;
+
+    const size_t slash = lut_filename.find_last_of('/');
+    m_index << m_version << ' ' << m_window_first_entry << ' ' << m_entries << ' '
+            << m_window_unix_begin << ' ' << static_cast<long long>(std::time(nullptr)) << ' '
+            << m_history_unix_begin.front();
+    for (long hits : m_sum_hits) m_index << ' ' << hits;
+    m_index << ' ' << (slash == std::string::npos ? lut_filename : lut_filename.substr(slash + 1)) << std::endl;
+    if (!m_index) throw TdcError("Cannot write LUT index file " + m_prefix + ".idx");
+}
+
+void LutTimeline::load(const std::string& index_path) {
+    std::ifstream index(index_path);
+    if (!index.is_open()) throw TdcError("Cannot open LUT index file " + index_path);
+
+    const size_t slash = index_path.find_last_of('/');
+    const std::string directory = (slash == std::string::npos) ? "" : index_path.substr(0, slash + 1);
+
+    m_begin.clear();
+    m_luts.clear();
+    m_end_entry = 0;
+    std::string line;
+    while (std::getline(index, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::stringstream ss(line);
+        int version;
+        uint64_t first_entry, end_entry;
+        long long unix_begin, unix_end, stat_unix_begin;
+        long hits[TDC_CHANNELS];
+        std::string filename;
+        if (!(ss >> version >> first_entry >> end_entry >> unix_begin >> unix_end >> stat_unix_begin
+                 >> hits[0] >> hits[1] >> hits[2] >> hits[3] >> filename)) {
+            throw TdcError("Invalid LUT index line: " + line);
+        }
+
+        std::vector<short> lut(TDC_CHANNELS * TDC_CODES);
+        std::ifstream lut_file(directory + filename, std::ios::binary);
+        if (!lut_file.read(reinterpret_cast<char*>(lut.data()), lut.size() * sizeof(short))) {
+            throw TdcError("Cannot read LUT snapshot " + directory + filename);
+        }
+        if (end_entry < first_entry || (!m_begin.empty() && first_entry != m_end_entry)) {
+            throw TdcError("LUT snapshots are not contiguous in entry order: " + filename);
+        }
+        m_begin.push_back(first_entry);
+        m_luts.push_back(std::move(lut));
+        m_end_entry = end_entry;
+    }
+    if (m_begin.empty()) {
+        // 모니터가 비활성화되었거나 hit이 없던 실행의 인덱스: 적용하면 모든 값이 0이 됨
+        throw TdcError("LUT index contains no snapshots: " + index_path);
+    }
+
+    m_current = nullptr;
+    m_current_begin = 1;
+    m_current_end = 0;
+}
+
+void LutTimeline::checkEntries(uint64_t entries) const {
+    if (entries != m_end_entry) {
+        throw TdcError("LUT index covers " + std::to_string(m_end_entry) + " entries but the tree has " +
+                       std::to_string(entries) + " (index from a different run, or drift monitor stopped early)");
+    }
+}
+
+void LutTimeline::seek(uint64_t entry) {
+    if (m_begin.empty()) {
+        m_current_begin = 0;
+        m_current_end = std::numeric_limits<uint64_t>::max();
+        return;
+    }
+    // entry 이하의 마지막 스냅샷 (첫 스냅샷 이전의 hit은 첫 스냅샷을 사용)
+    size_t i = std::upper_bound(m_begin.begin(), m_begin.end(), entry) - m_begin.begin();
+    i = (i == 0) ? 0 : i - 1;
+    m_current = m_luts[i].data();
+    m_current_begin = (i == 0) ? 0 : m_begin[i];
+    m_current_end = (i + 1 < m_begin.size()) ? m_begin[i + 1] : std::numeric_limits<uint64_t>::max();
+}
@@ -0,0 +1,140 @@
+#ifndef TDC_CALIBRATION_H
+#define TDC_CALIBRATION_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/// @brief TDC 코드 범위(12비트)와 채널 수. LUT 파일은 채널 순서대로 TDC_CODES개의 short 값을 저장합니다.
+constexpr int TDC_CODES = 4096;
+constexpr int TDC_CHANNELS = 4;
+
+/**
+ * @brief TDC 코드 히스토그램으로부터 누적합(cumulative-sum) 방식의 LUT를 계산합니다.
+ *
+ * 무작위 입력에 대해 각 코드의 폭은 해당 코드의 hit 비율에 비례하므로,
+ * 누적 분포의 중심값을 0~1000 범위로 환산한 값을 코드별 보정값으로 사용합니다. (tdc_calibrator와 동일한 알고리즘)
+ * @param hist 코드별 hit 수 (크기 TDC_CODES)
+ * @param lut 출력 LUT (크기 TDC_CODES)
+ */
+void computeLut(const std::vector<long>& hist, std::vector<short>& lut);
+
+/**
+ * @class LutDriftMonitor
+ * @brief 물리 데이터의 TDC 코드 히스토그램을 DAQ 루프 안에서 누적하여, 온도 드리프트에 따라 LUT를 주기적으로 갱신하는 클래스.
+ *
+ * 호스트 시계 기준 window_sec 길이의 시간 창(window)마다 채널별 히스토그램을 만들고,
+ * 최근 windows_per_lut 개 창의 합(sliding sum)을 증분 방식으로 유지합니다. 창이 닫힐 때마다 LUT를 다시 계산하여
+ * `<prefix>_v0001.lut` 형식의 스냅샷 파일(tdc_calibrator 출력과 동일한 포맷)로 저장하고, `<prefix>.idx`에
+ * 적용 범위(hit 번호 = TTree entry 번호)와 유닉스 시간 범위를 기록합니다.
+ * TDC 하드웨어 타임스탬프는 40비트(8ps 단위, 약 8.8초 주기)로 되돌아오므로 시간 축으로 사용하지 않습니다.
+ * 통계가 min_counts 미만인 채널은 이전 LUT를 그대로 사용합니다.
+ *
+ * 스냅샷 기록 중 오류가 발생하면 오류를 출력하고 모니터를 비활성화할 뿐, DAQ 루프로 예외를 전파하지 않습니다.
+ */
+class LutDriftMonitor {
+public:
+    /// @brief 설정 오류(창 길이, 인덱스 파일 생성 실패)는 TdcError로 보고합니다. DAQ 시작 전에 생성하세요.
+    LutDriftMonitor(const std::string& prefix, int window_sec, int windows_per_lut, long min_counts = 10000);
+    ~LutDriftMonitor();
+
+    LutDriftMonitor(const LutDriftMonitor&) = delete;
+    LutDriftMonitor& operator=(const LutDriftMonitor&) = delete;
+
+    /**
+     * @brief hit 하나를 누적합니다.
+     * @note TTree에 Fill한 hit마다 빠짐없이 한 번씩 호출해야 hit 번호가 TTree entry 번호와 일치합니다.
+     */
+    void add(unsigned channel, unsigned tdc) noexcept {
+        if (m_enabled && channel >= 1 && channel <= TDC_CHANNELS && tdc < TDC_CODES) {
+            m_window_hist[channel - 1][tdc]++;
+            m_window_hits++;
+        }
+        m_entries++;
+    }
+
+    /// @brief 현재 창이 끝났으면 LUT를 재계산하고 스냅샷을 기록합니다. DAQ 루프에서 데이터를 읽을 때마다 호출합니다.
+    void update() noexcept;
+
+    /// @brief 마지막(미완성) 창을 닫고 스냅샷을 기록합니다. DAQ 종료 시 호출합니다.
+    void finish() noexcept;
+
+    /// @brief 지금까지 기록한 스냅샷 수를 반환합니다.
+    int snapshotCount() const { return m_version; }
+    /// @brief 오류로 비활성화되지 않았으면 true를 반환합니다.
+    bool isEnabled() const { return m_enabled; }
+
+private:
+    using Histogram = std::vector<long>;
+    using Clock = std::chrono::steady_clock;
+
+    std::string m_prefix;
+    int m_window_sec;
+    uint64_t m_windows_per_lut;
+    long m_min_counts;
+
+    Clock::time_point m_start;
+    uint64_t m_window_index = 0;       // 시작 후 몇 번째 창인지
+    uint64_t m_window_first_entry = 0; // 현재 창의 첫 hit 번호
+    long long m_window_unix_begin = 0;
+    uint64_t m_entries = 0;            // 지금까지 add()된 hit 수
+    long m_window_hits = 0;
+    int m_version = 0;
+    bool m_enabled = true;
+    bool m_finished = false;
+
+    std::array<Histogram, TDC_CHANNELS> m_window_hist;             // 현재 창
+    std::deque<std::array<Histogram, TDC_CHANNELS>> m_history;     // 최근 창들 (오래된 순)
+    std::deque<uint64_t> m_history_index;                          // 각 창의 번호
+    std::deque<long long> m_history_unix_begin;                    // 각 창의 시작 유닉스 시간
+    std::array<Histogram, TDC_CHANNELS> m_sum;                     // m_history의 합
+    std::array<long, TDC_CHANNELS> m_sum_hits{};                   // m_sum의 채널별 총 hit 수
+    std::array<std::vector<short>, TDC_CHANNELS> m_lut;            // 현재 LUT
+    std::ofstream m_index;
+
+    void closeWindow();
+    void startWindow(uint64_t window_index);
+};
+
+/**
+ * @class LutTimeline
+ * @brief LutDriftMonitor가 기록한 버전별 LUT를 읽어, hit 번호(TTree entry 번호)에 맞는 LUT를 적용하는 클래스.
+ *
+ * 각 스냅샷은 자신의 첫 hit 번호부터 다음 스냅샷의 첫 hit 번호 직전까지 적용됩니다.
+ * 순서대로 읽는 데이터에서는 현재 구간을 벗어날 때만 LUT를 교체하므로, hit당 비용은 단일 LUT 조회와 같습니다.
+ */
+class LutTimeline {
+public:
+    /// @brief `<prefix>.idx` 인덱스 파일과 스냅샷 LUT 파일들을 읽습니다. 스냅샷이 하나도 없으면 TdcError를 던집니다.
+    void load(const std::string& index_path);
+
+    /// @brief 로드된 스냅샷 수를 반환합니다.
+    size_t size() const { return m_begin.size(); }
+    /// @brief 인덱스가 다루는 hit 수(마지막 스냅샷의 end_entry)를 반환합니다.
+    uint64_t entries() const { return m_end_entry; }
+    /// @brief 인덱스가 entries개의 hit을 가진 TTree와 같은 실행에서 기록되었는지 확인하고, 아니면 TdcError를 던집니다.
+    void checkEntries(uint64_t entries) const;
+
+    /// @brief 보정된 TDC 값을 반환합니다. 범위를 벗어난 channel/tdc는 0을 반환합니다.
+    short calibrate(unsigned channel, unsigned tdc, uint64_t entry) {
+        if (entry < m_current_begin || entry >= m_current_end) seek(entry);
+        if (!m_current || channel < 1 || channel > TDC_CHANNELS || tdc >= TDC_CODES) return 0;
+        return m_current[(channel - 1) * TDC_CODES + tdc];
+    }
+
+private:
+    std::vector<uint64_t> m_begin;          // 스냅샷별 첫 hit 번호
+    std::vector<std::vector<short>> m_luts; // 스냅샷별 TDC_CHANNELS * TDC_CODES
+    uint64_t m_end_entry = 0;               // 마지막 스냅샷의 end_entry
+    const short* m_current = nullptr;
+    uint64_t m_current_begin = 1;
+    uint64_t m_current_end = 0;
+
+    void seek(uint64_t entry);
+};
+
+#endif // TDC_CALIBRATION_H
@@ -7,6 +7,7 @@
 #include <stdexcept>
 #include <cstring>
 #include <cerrno>
+#include <algorithm>
 
 TdcController::TdcController() : m_socket_handle(-1) {}
 
@@ -68,9 +69,14 @@ void TdcController::transmit(const char* buffer, int length) {
 
 void TdcController::receive(char* buffer, int length) {
     if (!isConnected()) throw TdcError("Not connected to TDC");
-    int bytes_read = read(m_socket_handle, buffer, length);
-    if (bytes_read < length) {
-        throw TdcError("Receive failed or incomplete");
+    // 파이프라인 응답이나 큰 데이터 블록은 여러 TCP 세그먼트로 나뉘어 도착할 수 있으므로 모두 받을 때까지 반복
+    int total_read = 0;
+    while (total_read < length) {
+        int bytes_read = read(m_socket_handle, buffer + total_read, length - total_read);
+        if (bytes_read <= 0) {
+            throw TdcError("Receive failed or incomplete");
+        }
+        total_read += bytes_read;
     }
 }
 
@@ -89,6 +95,20 @@ int TdcController::readRegister(int address) {
     return static_cast<uint8_t>(response[0]);
 }
 
+void TdcController::writeRegisters(const std::vector<std::pair<int, int>>& writes) {
+    if (writes.empty()) return;
+    std::vector<char> buffer;
+    buffer.reserve(writes.size() * 3);
+    for (const auto& [address, data] : writes) {
+        buffer.push_back(1);
+        buffer.push_back(static_cast<char>(address & 0xFF));
+        buffer.push_back(static_cast<char>(data & 0xFF));
+    }
+    std::vector<char> response(writes.size());
+    transmit(buffer.data(), static_cast<int>(buffer.size()));
+    receive(response.data(), static_cast<int>(response.size()));
+}
+
 void TdcController::reset() { writeRegister(0x0, 0); }
 void TdcController::start() { writeRegister(0x1, 1); }
 void TdcController::stop() { writeRegister(0x1, 0); }
@@ -109,6 +129,14 @@ int TdcController::getThreshold(int channel) {
     return readRegister((channel - 1) + 0x04);
 }
 
+void TdcController::setThresholds(const std::array<int, 4>& values) {
+    std::vector<std::pair<int, int>> writes;
+    for (int ch = 1; ch <= 4; ++ch) {
+        writes.emplace_back((ch - 1) + 0x04, values[ch - 1]);
+    }
+    writeRegisters(writes);
+}
+
 void TdcController::setRawMode(bool enable) {
     writeRegister(0xB, enable ? 1 : 0);
 }
@@ -121,19 +149,27 @@ void TdcController::initializeTdc() {
 }
 
 int TdcController::getDataSize() {
-    writeRegister(0x8, 0); // Latch data size
-    int lsb = readRegister(0x8);
-    int msb = readRegister(0x9);
+    // Latch data size -> LSB 읽기 -> MSB 읽기를 하나의 패킷으로 전송 (응답 3바이트: ack, lsb, msb)
+    char cmd[7] = {1, 0x8, 0, 2, 0x8, 2, 0x9};
+    char response[3];
+    transmit(cmd, 7);
+    receive(response, 3);
+    int lsb = static_cast<uint8_t>(response[1]);
+    int msb = static_cast<uint8_t>(response[2]);
     return (msb << 8) | lsb;
 }
 
 std::vector<char> TdcController::readData(int event_count) {
-    int bytes_to_read = event_count * 8;
-    std::vector<char> buffer(bytes_to_read);
-    
-    char cmd[3] = {3, static_cast<char>(bytes_to_read & 0xFF), static_cast<char>((bytes_to_read >> 8) & 0xFF)};
-    transmit(cmd, 3);
-    receive(buffer.data(), bytes_to_read);
-    
+    std::vector<char> buffer(static_cast<size_t>(event_count) * 8);
+
+    // 읽기 명령의 길이 필드는 16비트(바이트 단위)이므로 최대 8191 이벤트씩 나누어 요청
+    const int MAX_EVENTS_PER_READ = 0xFFFF / 8;
+    for (int offset = 0; offset < event_count; offset += MAX_EVENTS_PER_READ) {
+        int bytes_to_read = std::min(event_count - offset, MAX_EVENTS_PER_READ) * 8;
+        char cmd[3] = {3, static_cast<char>(bytes_to_read & 0xFF), static_cast<char>((bytes_to_read >> 8) & 0xFF)};
+        transmit(cmd, 3);
+        receive(buffer.data() + static_cast<size_t>(offset) * 8, bytes_to_read);
+    }
+
     return buffer;
 }
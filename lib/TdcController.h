@@ -1,8 +1,10 @@
 #ifndef TDC_CONTROLLER_H
 #define TDC_CONTROLLER_H
 
+#include <array>
 #include <string>
 #include <vector>
+#include <utility>
 #include <stdexcept>
 
 /**
@@ -45,13 +47,19 @@ public:
     // --- 설정 ---
     void setThreshold(int channel, int value);
     int getThreshold(int channel);
+    /**
+     * @brief 4개 채널의 임계값을 한 번에 설정합니다.
+     * @note 4개의 레지스터 쓰기 명령을 하나의 패킷으로 묶어 전송하고 응답을 일괄 수신하므로,
+     * setThreshold()를 4번 호출하는 것보다 왕복(round-trip) 횟수가 4배 적습니다.
+     */
+    void setThresholds(const std::array<int, 4>& values);
     void setRawMode(bool enable);
     void initializeTdc();
 
     // --- 데이터 읽기 ---
-    /// @brief TDC 내부 버퍼에 쌓인 이벤트의 개수를 반환합니다.
+    /// @brief TDC 내부 버퍼에 쌓인 이벤트의 개수를 반환합니다. (latch/LSB/MSB 접근을 한 번의 왕복으로 처리)
     int getDataSize();
-    /// @brief 지정된 개수만큼의 이벤트 데이터를 읽어 반환합니다. (1 이벤트 = 8 바이트)
+    /// @brief 지정된 개수만큼의 이벤트 데이터를 읽어 반환합니다. (1 이벤트 = 8 바이트, 8191 이벤트 단위로 나누어 요청)
     std::vector<char> readData(int event_count);
 
 private:
@@ -62,6 +70,8 @@ private:
     void receive(char* buffer, int length);
     void writeRegister(int address, int data);
     int readRegister(int address);
+    /// @brief 여러 레지스터 쓰기 명령을 파이프라인으로 전송한 뒤 응답을 한꺼번에 수신합니다.
+    void writeRegisters(const std::vector<std::pair<int, int>>& writes);
 };
 
 /// @brief TDC 관련 작업 중 발생하는 오류를 위한 예외 클래스